@@ -5,12 +5,33 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundCue.h"
+#include "Engine/SkeletalMesh.h"
 #include "Engine/SkeletalMeshSocket.h"
 #include "DrawDebugHelpers.h"
 #include "Particles/ParticleSystemComponent.h"
+#include "GameFramework/PlayerState.h"
+#include "ShotTelemetry.h"
+#include "ShooterCharacterMovementComponent.h"
+
+// Names used on every shot, built once instead of per call
+static const FName BeamTargetParamName(TEXT("Target"));
+static const FName StartFireSectionName(TEXT("StartFire"));
+
+LLM_DEFINE_TAG(ShooterFire);
+
+DECLARE_CYCLE_STAT(TEXT("FireWeapon"), STAT_ShooterFireWeapon, STATGROUP_ShooterFire);
+DECLARE_CYCLE_STAT(TEXT("GetCrosshairAim"), STAT_ShooterCrosshairAim, STATGROUP_ShooterFire);
+DECLARE_CYCLE_STAT(TEXT("GetBeamEndLocation"), STAT_ShooterBeamEndLocation, STATGROUP_ShooterFire);
+// Shooter id lookup plus building and queueing each FShotRecord, budget is under 100ns per shot
+DECLARE_CYCLE_STAT(TEXT("Shot Telemetry"), STAT_ShooterShotTelemetry, STATGROUP_ShooterFire);
+// Running total since startup, the shot rate the live counts are read against
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Shots Fired"), STAT_ShooterShotsFired, STATGROUP_ShooterFire);
+// Up on spawn, down when the emitter finishes. Stays flat unless shots leave emitters behind
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Live Fire Emitters"), STAT_ShooterLiveFireEmitters, STATGROUP_ShooterFire);
 
 // Sets default values
-AShooterCharacter::AShooterCharacter() :
+AShooterCharacter::AShooterCharacter(const FObjectInitializer& ObjectInitializer) :
+	Super(ObjectInitializer.SetDefaultSubobjectClass<UShooterCharacterMovementComponent>(ACharacter::CharacterMovementComponentName)),
     //Base rates for turning/looking up
 	BaseTurnRate(45.f),
 	BaseLookUpRate(45.f),
@@ -25,6 +46,7 @@ MouseHipLookUpRate(1.0F),
 MouseAimingTurnRate(0.2F),
 MouseAimingLookUpRate(0.2F),
     bAiming(false),
+    AimState(EAimState::EAS_Hip),
     //Camera field of view values
     CameraDefaultFOV(0.F), //Set in BeginPlay
     CameraZoomedFOV(35.F),
@@ -44,10 +66,19 @@ MouseAimingLookUpRate(0.2F),
   bFireButtonPressed(false),
   //Bullet fire timer variables
   ShootTimeDuration(0.05f),
-  bFiringBullet(false)
+  bFiringBullet(false),
+  bCrosshairSpreadSettled(false),
+  bCrosshairViewChanged(false),
+  ShotsFired(0),
+  //Muzzle transforms computed on first use
+  MuzzleTransformFrame(TNumericLimits<uint64>::Max()),
+  //Hitscan trace settings
+  WeaponMaxRange(50'000.f),
+  WeaponTraceChannel(ECollisionChannel::ECC_Visibility),
+  bBarrelTraceOnly(false)
     
 {
- 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+ 	// Set this character to call Tick() every frame. Tick turns itself off when HasActivePerFrameWork is false.
 	PrimaryActorTick.bCanEverTick = true;
 
 	// Create a camera boom (pulls in towards the character if there is a collision)
@@ -73,6 +104,9 @@ MouseAimingLookUpRate(0.2F),
 	GetCharacterMovement()->RotationRate = FRotator(0.f, 540.f, 0.f); // ... at this rotation rate
 	GetCharacterMovement()->JumpZVelocity = 600.f;
 	GetCharacterMovement()->AirControl = 0.2f;
+
+	// Single barrel by default, add more sockets to fire them together
+	MuzzleSocketNames.Add(FName("Barrel_Socket"));
 }
 
 // Called when the game starts or when spawned
@@ -85,6 +119,26 @@ void AShooterCharacter::BeginPlay()
 		CameraDefaultFOV=GetFollowCamera()->FieldOfView;
 		CameraCurrentFOV=CameraDefaultFOV;
 	}
+	// Look rates are only applied on aim state changes, start with the hip rates
+	SetLookRates();
+}
+
+void AShooterCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+#if STATS
+	// Emitters still playing will never call back into us, stop counting them
+	for (const TWeakObjectPtr<UParticleSystemComponent>& Emitter : LiveFireEmitters)
+	{
+		if (Emitter.IsValid())
+		{
+			Emitter->OnSystemFinished.RemoveDynamic(this, &AShooterCharacter::OnFireEmitterFinished);
+		}
+	}
+	DEC_DWORD_STAT_BY(STAT_ShooterLiveFireEmitters, LiveFireEmitters.Num());
+	LiveFireEmitters.Empty();
+#endif
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AShooterCharacter::MoveFoward(float Value)
@@ -97,6 +151,8 @@ void AShooterCharacter::MoveFoward(float Value)
 
 		const FVector Direction{ FRotationMatrix{YawRotation}.GetUnitAxis(EAxis::X) };
 		AddMovementInput(Direction, Value);
+		// Crosshair spread follows velocity, and the view moves with us
+		MarkCrosshairViewChanged();
 	}
 }
 
@@ -110,6 +166,8 @@ void AShooterCharacter::MoveRight(float Value)
 
 		const FVector Direction{ FRotationMatrix{YawRotation}.GetUnitAxis(EAxis::Y) };
 		AddMovementInput(Direction, Value);
+		// Crosshair spread follows velocity, and the view moves with us
+		MarkCrosshairViewChanged();
 	}
 }
 
@@ -117,11 +175,19 @@ void AShooterCharacter::TurnAtRate(float Rate)
 {
 	// calculate delta for this frame from the rate information
 	AddControllerYawInput(Rate * BaseTurnRate * GetWorld()->GetDeltaSeconds()); // deg/sec * sec/frame
+	if (Rate != 0.f)
+	{
+		MarkCrosshairViewChanged();
+	}
 }
 
 void AShooterCharacter::LookAtRate(float Rate)
 {
 	AddControllerPitchInput(Rate * BaseLookUpRate * GetWorld()->GetDeltaSeconds()); // deg/sec * sec/frame
+	if (Rate != 0.f)
+	{
+		MarkCrosshairViewChanged();
+	}
 }
 
 void AShooterCharacter::Turn(float value)
@@ -136,6 +202,10 @@ void AShooterCharacter::Turn(float value)
 		TurnScaleFactor=MouseHipTurnRate;
 	}
 	AddControllerYawInput(value * TurnScaleFactor);
+	if (value != 0.f)
+	{
+		MarkCrosshairViewChanged();
+	}
 }
 
 void AShooterCharacter::Lookup(float value)
@@ -150,36 +220,91 @@ void AShooterCharacter::Lookup(float value)
 		LookUpScaleFactor=MouseHipTurnRate;
 	}
 	AddControllerPitchInput(value * LookUpScaleFactor);
+	if (value != 0.f)
+	{
+		MarkCrosshairViewChanged();
+	}
 }
 
 
 void AShooterCharacter::FireWeapon()
 {
+	SCOPE_CYCLE_COUNTER(STAT_ShooterFireWeapon);
+	LLM_SCOPE_BYTAG(ShooterFire);
+	INC_DWORD_STAT(STAT_ShooterShotsFired);
+	++ShotsFired;
+
 	if (FireSound)
 	{
 		UGameplayStatics::PlaySound2D(this, FireSound);
 	}
-	const USkeletalMeshSocket* BarrelSocket = GetMesh()->GetSocketByName("Barrel_Socket");
-	if (BarrelSocket)
+	// Telemetry off costs this one branch, no id lookup and no records
+	const bool bShotTelemetry = FShotTelemetry::IsEnabled();
+
+	// Shooter id stays the same for the session, unlike GetUniqueID which is recycled with the object slot
+	uint32 ShooterId = 0;
+	uint8 ShooterIdFlags = 0;
+	if (bShotTelemetry)
 	{
-		const FTransform SocketTransform = BarrelSocket->GetSocketTransform(GetMesh());
+		SCOPE_CYCLE_COUNTER(STAT_ShooterShotTelemetry);
+		if (const APlayerState* ShooterPlayerState = GetPlayerState())
+		{
+			ShooterId = static_cast<uint32>(ShooterPlayerState->GetPlayerId());
+			ShooterIdFlags = EShotFlags::ShooterIdIsPlayerId;
+		}
+		else
+		{
+			ShooterId = HashCombine(GetTypeHash(GetFName()), GetTypeHash(CreationTime));
+		}
+	}
 
-		if (MuzzleFlash)
+	// The crosshairs are the same for every muzzle in the batch, deproject and screen trace once
+	FVector AimTarget;
+	uint8 AimTraceFlags = 0;
+	const bool bHasAim = GetCrosshairAim(AimTarget, AimTraceFlags);
+
+	const TArray<FMuzzleAttachment>& Muzzles = GetMuzzleAttachments();
+	for (int32 MuzzleIndex = 0; MuzzleIndex < Muzzles.Num(); ++MuzzleIndex)
+	{
+		const FTransform& SocketTransform = Muzzles[MuzzleIndex].WorldTransform;
+
+		UParticleSystem* Flash = (MuzzleIndex % 2 == 1 && MuzzleFlash1) ? MuzzleFlash1 : MuzzleFlash;
+		if (Flash)
 		{
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleFlash, SocketTransform);
+			TrackFireEmitter(UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), Flash, SocketTransform));
 		}
 
-		FVector BeamEnd;
-		bool bBeamEnd = GetBeamEndLocation(
-			SocketTransform.GetLocation(), BeamEnd);
-		if (bBeamEnd)
+		FVector BeamEnd = FVector::ZeroVector;
+		uint8 TraceFlags = AimTraceFlags;
+		if (bHasAim)
+		{
+			GetBeamEndLocation(SocketTransform.GetLocation(), AimTarget, BeamEnd, TraceFlags);
+		}
+
+		// Every shot is logged, including ones with no crosshairs to trace from
+		if (bShotTelemetry)
+		{
+			SCOPE_CYCLE_COUNTER(STAT_ShooterShotTelemetry);
+			FShotRecord Shot{};
+			Shot.TimeSeconds = GetWorld()->GetTimeSeconds();
+			Shot.ShooterId = ShooterId;
+			Shot.MuzzleLocation = SocketTransform.GetLocation();
+			Shot.BeamEnd = BeamEnd;
+			Shot.SpreadMultiplier = CrosshairSpreadMultiplier;
+			Shot.Flags = static_cast<uint8>(TraceFlags | ShooterIdFlags |
+				(bAiming ? EShotFlags::Aiming : 0) |
+				(bHasAim ? 0 : EShotFlags::NoDeprojection));
+			FShotTelemetry::Record(Shot);
+		}
+
+		if (bHasAim)
 		{
 			if (ImpactParticles)
 			{
-				UGameplayStatics::SpawnEmitterAtLocation(
+				TrackFireEmitter(UGameplayStatics::SpawnEmitterAtLocation(
 					GetWorld(),
 					ImpactParticles,
-					BeamEnd);
+					BeamEnd));
 			}
 
 			UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(
@@ -188,7 +313,8 @@ void AShooterCharacter::FireWeapon()
 				SocketTransform);
 			if (Beam)
 			{
-				Beam->SetVectorParameter(FName("Target"), BeamEnd);
+				Beam->SetVectorParameter(BeamTargetParamName, BeamEnd);
+				TrackFireEmitter(Beam);
 			}
 		}
 	}
@@ -196,12 +322,69 @@ void AShooterCharacter::FireWeapon()
 	if (AnimInstance && HipFireMontage)
 	{
 		AnimInstance->Montage_Play(HipFireMontage);
-		AnimInstance->Montage_JumpToSection(FName("StartFire"));
+		AnimInstance->Montage_JumpToSection(StartFireSectionName);
 	}
 	
 	// Start bullet fire timer for crosshairs
 	StartCrosshairBulletFire();
 }
+
+void AShooterCharacter::TrackFireEmitter(UParticleSystemComponent* Emitter)
+{
+#if STATS
+	if (Emitter)
+	{
+		Emitter->OnSystemFinished.AddDynamic(this, &AShooterCharacter::OnFireEmitterFinished);
+		LiveFireEmitters.Add(Emitter);
+		INC_DWORD_STAT(STAT_ShooterLiveFireEmitters);
+	}
+#endif
+}
+
+void AShooterCharacter::OnFireEmitterFinished(UParticleSystemComponent* Emitter)
+{
+#if STATS
+	if (LiveFireEmitters.RemoveSingleSwap(Emitter) > 0)
+	{
+		DEC_DWORD_STAT(STAT_ShooterLiveFireEmitters);
+	}
+#endif
+}
+
+const TArray<FMuzzleAttachment>& AShooterCharacter::GetMuzzleAttachments()
+{
+	USkeletalMeshComponent* MeshComponent = GetMesh();
+	if (MuzzleMesh != MeshComponent->SkeletalMesh)
+	{
+		// Mesh changed, look the sockets up by name once and keep their bone indices
+		MuzzleMesh = MeshComponent->SkeletalMesh;
+		MuzzleAttachments.Reset();
+		for (const FName& SocketName : MuzzleSocketNames)
+		{
+			const USkeletalMeshSocket* Socket = MeshComponent->GetSocketByName(SocketName);
+			if (Socket)
+			{
+				const int32 BoneIndex = MeshComponent->GetBoneIndex(Socket->BoneName);
+				if (BoneIndex != INDEX_NONE)
+				{
+					MuzzleAttachments.Add({ BoneIndex, Socket->GetSocketLocalTransform(), FTransform::Identity });
+				}
+			}
+		}
+		MuzzleTransformFrame = TNumericLimits<uint64>::Max();
+	}
+
+	if (MuzzleTransformFrame != GFrameCounter)
+	{
+		// Every shot this frame shares the bone transforms current at the first shot
+		MuzzleTransformFrame = GFrameCounter;
+		for (FMuzzleAttachment& Muzzle : MuzzleAttachments)
+		{
+			Muzzle.WorldTransform = Muzzle.LocalTransform * MeshComponent->GetBoneTransform(Muzzle.BoneIndex);
+		}
+	}
+	return MuzzleAttachments;
+}
 	if (FireSound)
 	{
 		UGameplayStatics::PlaySound2D(this, FireSound);
@@ -244,67 +427,111 @@ void AShooterCharacter::FireWeapon()
 }
 
 
-bool AShooterCharacter::GetBeamEndLocation(
-	const FVector& MuzzleSocketLocation,
-	FVector& OutBeamLocation)
+bool AShooterCharacter::GetCrosshairAim(
+	FVector& OutAimTarget,
+	uint8& OutTraceFlags)
 {
-	// Get current size of the viewport
-	FVector2D ViewportSize;
-	if (GEngine && GEngine->GameViewport)
-	{
-		GEngine->GameViewport->GetViewportSize(ViewportSize);
-	}
+	SCOPE_CYCLE_COUNTER(STAT_ShooterCrosshairAim);
+	OutTraceFlags = 0;
 
-	// Get screen space location of crosshairs
-	FVector2D CrosshairLocation(ViewportSize.X / 2.f, ViewportSize.Y / 2.f);
 	FVector CrosshairWorldPosition;
 	FVector CrosshairWorldDirection;
+	bool bScreenToWorld = false;
 
-	// Get world position and direction of crosshairs
-	bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(
-		UGameplayStatics::GetPlayerController(this, 0),
-		CrosshairLocation,
-		CrosshairWorldPosition,
-		CrosshairWorldDirection);
+	if (IsPlayerControlled() && IsLocallyControlled())
+	{
+		// Get current size of the viewport
+		FVector2D ViewportSize;
+		if (GEngine && GEngine->GameViewport)
+		{
+			GEngine->GameViewport->GetViewportSize(ViewportSize);
+		}
+
+		// Get screen space location of crosshairs
+		FVector2D CrosshairLocation(ViewportSize.X / 2.f, ViewportSize.Y / 2.f);
+
+		// Get world position and direction of crosshairs
+		bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(
+			UGameplayStatics::GetPlayerController(this, 0),
+			CrosshairLocation,
+			CrosshairWorldPosition,
+			CrosshairWorldDirection);
+	}
+	else
+	{
+		// Bots and pawns controlled elsewhere have no crosshairs, aim from their own eyes
+		FRotator EyesRotation;
+		GetActorEyesViewPoint(CrosshairWorldPosition, EyesRotation);
+		CrosshairWorldDirection = EyesRotation.Vector();
+		bScreenToWorld = true;
+	}
 
 	if (bScreenToWorld) // was deprojection successful?
 	{
-		FHitResult ScreenTraceHit;
+		// Tagged so trace cost shows up in the scene query stats, and the shooter never blocks its own shot
+		const FCollisionQueryParams QueryParams{ SCENE_QUERY_STAT(ShooterWeaponTrace), false, this };
+
+		// Range is measured from the crosshairs whichever traces run
 		const FVector Start{ CrosshairWorldPosition };
-		const FVector End{ CrosshairWorldPosition + CrosshairWorldDirection * 50'000.f };
+		const FVector End{ CrosshairWorldPosition + CrosshairWorldDirection * WeaponMaxRange };
 
-		// Set beam end point to line trace end point
-		OutBeamLocation = End;
-
-		// Trace outward from crosshairs world location
-		GetWorld()->LineTraceSingleByChannel(
-			ScreenTraceHit,
-			Start,
-			End,
-			ECollisionChannel::ECC_Visibility);
-		if (ScreenTraceHit.bBlockingHit) // was there a trace hit?
+		// Set aim target to line trace end point
+		OutAimTarget = End;
+
+		if (bBarrelTraceOnly)
 		{
-			// Beam end point is now trace hit location
-			OutBeamLocation = ScreenTraceHit.Location;
+			// No parallax between camera and barrel to correct, the barrel trace alone finds the hit
+			OutTraceFlags |= EShotFlags::ScreenTraceSkipped;
 		}
-
-		// Perform a second trace, this time from the gun barrel
-		FHitResult WeaponTraceHit;
-		const FVector WeaponTraceStart{ MuzzleSocketLocation };
-		const FVector WeaponTraceEnd{ OutBeamLocation };
-		GetWorld()->LineTraceSingleByChannel(
-			WeaponTraceHit,
-			WeaponTraceStart,
-			WeaponTraceEnd,
-			ECollisionChannel::ECC_Visibility);
-		if (WeaponTraceHit.bBlockingHit) // object between barrel and BeamEndPoint?
+		else
 		{
-			OutBeamLocation = WeaponTraceHit.Location;
+			// Trace outward from crosshairs world location
+			FHitResult ScreenTraceHit;
+			GetWorld()->LineTraceSingleByChannel(
+				ScreenTraceHit,
+				Start,
+				End,
+				WeaponTraceChannel,
+				QueryParams);
+			if (ScreenTraceHit.bBlockingHit) // was there a trace hit?
+			{
+				// Aim target is now trace hit location
+				OutAimTarget = ScreenTraceHit.Location;
+				OutTraceFlags |= EShotFlags::ScreenTraceHit;
+			}
 		}
 		return true;
 	}
 	return false;
 }
+
+void AShooterCharacter::GetBeamEndLocation(
+	const FVector& MuzzleSocketLocation,
+	const FVector& AimTarget,
+	FVector& OutBeamLocation,
+	uint8& OutTraceFlags)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterBeamEndLocation);
+
+	// Set beam end point to the crosshair aim target
+	OutBeamLocation = AimTarget;
+
+	// Perform a second trace, this time from the gun barrel
+	// Tagged so trace cost shows up in the scene query stats, and the shooter never blocks its own shot
+	const FCollisionQueryParams QueryParams{ SCENE_QUERY_STAT(ShooterWeaponTrace), false, this };
+	FHitResult WeaponTraceHit;
+	GetWorld()->LineTraceSingleByChannel(
+		WeaponTraceHit,
+		MuzzleSocketLocation,
+		AimTarget,
+		WeaponTraceChannel,
+		QueryParams);
+	if (WeaponTraceHit.bBlockingHit) // object between barrel and BeamEndPoint?
+	{
+		OutBeamLocation = WeaponTraceHit.Location;
+		OutTraceFlags |= EShotFlags::WeaponTraceHit;
+	}
+}
 	//Get current size of the viewport
 	FVector2D ViewPortSize;
 	if (GEngine && GEngine->GameViewport)
@@ -357,11 +584,55 @@ bool AShooterCharacter::GetBeamEndLocation(
 void AShooterCharacter::AimingButtonPressed()
 {
 	bAiming = true;
+	SetAimState(EAimState::EAS_ZoomingIn);
 }
 
 void AShooterCharacter::AimingButtonReleased()
 {
 	bAiming = false;
+	SetAimState(EAimState::EAS_ZoomingOut);
+}
+
+void AShooterCharacter::SetAimState(EAimState NewAimState)
+{
+	AimState = NewAimState;
+	// Change look sensitivity based on aiming
+	SetLookRates();
+	// Zoom and crosshair aim factor interpolate in Tick
+	SetActorTickEnabled(true);
+}
+
+bool AShooterCharacter::HasActivePerFrameWork() const
+{
+	if (AimState == EAimState::EAS_ZoomingIn || AimState == EAimState::EAS_ZoomingOut)
+	{
+		return true;
+	}
+	return bCrosshairViewChanged ||
+		bFiringBullet ||
+		!bCrosshairSpreadSettled ||
+		GetCharacterMovement()->IsFalling() ||
+		!GetVelocity().IsNearlyZero();
+}
+
+void AShooterCharacter::OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PrevMovementMode, PreviousCustomMode);
+
+	// Jumping and landing change the in air crosshair spread
+	SetActorTickEnabled(true);
+}
+
+void AShooterCharacter::MarkCrosshairViewChanged()
+{
+	bCrosshairViewChanged = true;
+	SetActorTickEnabled(true);
+}
+
+void AShooterCharacter::OnMovementStartedOrStopped()
+{
+	// Starting and stopping both change the crosshair spread
+	SetActorTickEnabled(true);
 }
 
 
@@ -371,22 +642,34 @@ void AShooterCharacter::Tick(float DeltaTime)
 
 	// Handle interpolation for zoom when aiming
 	CameraInterpZoom(DeltaTime);
-	// Change look sensitivity based on aiming
-	SetLookRates();
 	// Calculate crosshair spread multiplier
+	const float PreviousSpreadMultiplier = CrosshairSpreadMultiplier;
 	CalculateCrosshairSpread(DeltaTime);
+	bCrosshairSpreadSettled = FMath::IsNearlyEqual(PreviousSpreadMultiplier, CrosshairSpreadMultiplier);
 
-	FHitResult ItemTraceResult;
-	TraceUnderCrosshairs(ItemTraceResult);
-	if (ItemTraceResult.bBlockingHit)
+	// Look and move input set the flag, momentum and knockback move the local player's view without input
+	const bool bLocalPlayerMoving = !GetVelocity().IsNearlyZero() && IsPlayerControlled() && IsLocallyControlled();
+	if (bCrosshairViewChanged || bLocalPlayerMoving)
 	{
-		AItem* HitItem = Cast<AItem>(ItemTraceResult.Actor);
-		if (HitItem && HitItem->GetPickupWidget())
+		bCrosshairViewChanged = false;
+		FHitResult ItemTraceResult;
+		TraceUnderCrosshairs(ItemTraceResult);
+		if (ItemTraceResult.bBlockingHit)
 		{
-			// Show Item's Pickup Widget
-			HitItem->GetPickupWidget()->SetVisibility(true);
+			AItem* HitItem = Cast<AItem>(ItemTraceResult.Actor);
+			if (HitItem && HitItem->GetPickupWidget())
+			{
+				// Show Item's Pickup Widget
+				HitItem->GetPickupWidget()->SetVisibility(true);
+			}
 		}
 	}
+
+	// Idle pawns stop ticking until input, movement or firing wakes them
+	if (!HasActivePerFrameWork())
+	{
+		SetActorTickEnabled(false);
+	}
 }
 // Called to bind functionality to input
 void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -407,6 +690,9 @@ void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCo
 	PlayerInputComponent->BindAction("Aimingbutton", IE_Pressed, this,&AShooterCharacter::AimingButtonPressed);
 	PlayerInputComponent->BindAction("Aimingbutton",IE_Released, this, &AShooterCharacter::AimingButtonReleased);
 
+	// Possessed by a player, trace once for items already under the crosshairs
+	MarkCrosshairViewChanged();
+
 }
 
 float AShooterCharacter::GetCrosshairSpreadMultiplier() const
@@ -416,19 +702,21 @@ float AShooterCharacter::GetCrosshairSpreadMultiplier() const
 
 void AShooterCharacter::CameraInterpZoom(float DeltaTime)
 {
-	//Set current Camera field of view
-	if (bAiming)
+	// FOV only changes during a zoom transition
+	if (AimState != EAimState::EAS_ZoomingIn && AimState != EAimState::EAS_ZoomingOut)
 	{
-		//Interpolate to zoomed FOV
-		CameraCurrentFOV=FMath::FInterpTo(CameraCurrentFOV, CameraZoomedFOV, DeltaTime,ZoomInterpSpeed);
-		GetFollowCamera()->SetFieldOfView(CameraCurrentFOV);
+		return;
 	}
-	else
+	//Interpolate to zoomed FOV when aiming, default FOV otherwise
+	const float TargetFOV = bAiming ? CameraZoomedFOV : CameraDefaultFOV;
+	CameraCurrentFOV=FMath::FInterpTo(CameraCurrentFOV, TargetFOV, DeltaTime,ZoomInterpSpeed);
+	if (FMath::IsNearlyEqual(CameraCurrentFOV, TargetFOV, 0.01f))
 	{
-		//Interpolate to default FOV
-		CameraCurrentFOV=FMath::FInterpTo(CameraCurrentFOV, CameraDefaultFOV, DeltaTime,ZoomInterpSpeed);
-		GetFollowCamera()->SetFieldOfView(CameraCurrentFOV);
+		//Zoom has converged, finish the transition
+		CameraCurrentFOV=TargetFOV;
+		AimState = bAiming ? EAimState::EAS_Aiming : EAimState::EAS_Hip;
 	}
+	GetFollowCamera()->SetFieldOfView(CameraCurrentFOV);
 }
 
 void AShooterCharacter::SetLookRates()
@@ -481,8 +769,9 @@ void AShooterCharacter::CalculateCrosshairSpread(float Deltatime)
 	{
 		CrosshairShootingFactor=FMath::FInterpTo(CrosshairShootingFactor, 0.3f, Deltatime, 60.f);
 	}
-	CrosshairSpreadMultiplier=0.5f+CrosshairVelocityFactor + CrosshairInAirFactor-CrosshairAimFactor + CrosshairShootingFactor;
+	// Velocity factor first, so an abrupt stop changes the multiplier this frame and Tick does not sleep on a stale spread
 	CrosshairVelocityFactor=FMath::GetMappedRangeValueClamped(WalkSpeedRange, VelocityMultiplierRange, Velocity.Size());
+	CrosshairSpreadMultiplier=0.5f+CrosshairVelocityFactor + CrosshairInAirFactor-CrosshairAimFactor + CrosshairShootingFactor;
 
 	
 	
@@ -501,6 +790,26 @@ void AShooterCharacter::FireButtonReleased()
 	bFireButtonPressed=false;
 }
 
+void AShooterCharacter::SetMuzzleSocketNames(const TArray<FName>& InMuzzleSocketNames)
+{
+	MuzzleSocketNames = InMuzzleSocketNames;
+	// Forget the resolved sockets, GetMuzzleAttachments resolves them again
+	MuzzleAttachments.Reset();
+	MuzzleMesh = nullptr;
+}
+
+void AShooterCharacter::HoldFireButton(bool bHeld)
+{
+	if (bHeld)
+	{
+		FireButtonPressed();
+	}
+	else
+	{
+		FireButtonReleased();
+	}
+}
+
 void AShooterCharacter::StartFireTimer()
 {
 	if (bShouldFire)
@@ -539,6 +848,8 @@ bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector&
 void AShooterCharacter::StartCrosshairBulletFire()
 {
 	bFiringBullet = true;
+	// Shooting factor interpolates in Tick
+	SetActorTickEnabled(true);
 
 	GetWorldTimerManager().SetTimer(
 		CrosshairShootTimer, 
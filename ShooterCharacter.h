@@ -6,19 +6,48 @@
 #include "GameFramework/Character.h"
 #include "ShooterCharacter.generated.h"
 
+// Stats for the weapon fire path. Sample with "stat ShooterFire" or "stat startfile"
+// during long sessions to spot growth in what each shot leaves behind.
+// Allocations made while firing are also tracked under the ShooterFire LLM tag.
+DECLARE_STATS_GROUP(TEXT("ShooterFire"), STATGROUP_ShooterFire, STATCAT_Advanced);
+
+// A muzzle socket resolved against the character mesh
+struct FMuzzleAttachment
+{
+	// Bone the socket is attached to
+	int32 BoneIndex;
+	// Socket transform relative to its bone
+	FTransform LocalTransform;
+	// Socket transform in world space, updated on the first GetMuzzleAttachments call each frame
+	FTransform WorldTransform;
+};
+
+UENUM(BlueprintType)
+enum class EAimState : uint8
+{
+	EAS_Hip UMETA(DisplayName = "Hip"),
+	EAS_ZoomingIn UMETA(DisplayName = "ZoomingIn"),
+	EAS_Aiming UMETA(DisplayName = "Aiming"),
+	EAS_ZoomingOut UMETA(DisplayName = "ZoomingOut"),
+
+	EAS_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
 UCLASS()
 class SHOOTERZX_API AShooterCharacter : public ACharacter
 {
 	GENERATED_BODY()
 
 public:
-	// Sets default values for this character's properties
-	AShooterCharacter();
+	// Sets default values for this character's properties. Uses UShooterCharacterMovementComponent for movement
+	AShooterCharacter(const FObjectInitializer& ObjectInitializer);
 
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	//Called for fowards/backwards input
 	void MoveFoward(float Value);
 
@@ -48,18 +77,44 @@ protected:
 	/** Called when the Fire Button is pressed */
 	void FireWeapon();
 
-	bool GetBeamEndLocation(const FVector& MuzzleSocketLocation, FVector& OutBeamLocation);
+	/* Muzzles with world transforms, computed on the first call each frame from the current bone
+	 * transforms. Fire from input runs before animation and sees the last evaluated pose.
+	 * Sockets are resolved again only when the mesh or MuzzleSocketNames change.
+	 **/
+	const TArray<FMuzzleAttachment>& GetMuzzleAttachments();
+
+	/** Deproject the crosshairs and trace from them to find what they point at, once per batch of muzzles
+	 *@param OutAimTarget The screen trace hit, or max range along the crosshairs
+	 *@param OutTraceFlags EShotFlags bits for the screen trace
+	 **/
+	bool GetCrosshairAim(FVector& OutAimTarget, uint8& OutTraceFlags);
+
+	/** Trace from one barrel to the crosshair aim target to find where its shot ends
+	 *@param OutTraceFlags EShotFlags bits, WeaponTraceHit is added when the barrel trace hits
+	 **/
+	void GetBeamEndLocation(const FVector& MuzzleSocketLocation, const FVector& AimTarget, FVector& OutBeamLocation, uint8& OutTraceFlags);
 
 	//** Set bAiming to true or false with button press */
 	void AimingButtonPressed();
 	void AimingButtonReleased();
 
+	// Enter a new aim state, applying look rates and starting any zoom transition
+	void SetAimState(EAimState NewAimState);
+
+	// Interpolate the camera FOV while a zoom transition is in flight
 	void CameraInterpZoom(float DeltaTime);
-	//Set BaseTurnRate and BaseLookUpRate based on Aiming
 	
-	// SetBaseTurnRate and BaseLookUpRate
+	// SetBaseTurnRate and BaseLookUpRate based on Aiming
 	void SetLookRates();
-	
+
+	// True while Tick has something to do: zooming, moving, firing, crosshairs still settling, or an item trace pending
+	bool HasActivePerFrameWork() const;
+
+	// The view under the crosshairs moved, wake Tick for one item trace
+	void MarkCrosshairViewChanged();
+
+	virtual void OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode = 0) override;
+
 	void CalculateCrosshairSpread(float Deltatime);
 
 	//Functions when fire the weapon
@@ -78,6 +133,12 @@ protected:
 
 	UFUNCTION()
 	void FinishCrosshairBulletFire();
+
+	// Count a fire emitter as live until it finishes. Does nothing when stats are compiled out
+	void TrackFireEmitter(class UParticleSystemComponent* Emitter);
+
+	UFUNCTION()
+	void OnFireEmitterFinished(class UParticleSystemComponent* Emitter);
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -143,6 +204,20 @@ private:
 	class UParticleSystem* MuzzleFlash;
 	UPROPERTY(EditAnywhere,BlueprintReadWrite, Category= "Combat", meta=(AllowPrivateAccess="true"))
 	class UParticleSystem* MuzzleFlash1;
+
+	//Sockets a shot leaves from, all fired in one batch. MuzzleFlash plays on even muzzles, MuzzleFlash1 on odd ones
+	//Change at runtime through SetMuzzleSocketNames so the cached sockets are resolved again
+	UPROPERTY(EditDefaultsOnly,BlueprintReadOnly, Category= "Combat", meta=(AllowPrivateAccess="true"))
+	TArray<FName> MuzzleSocketNames;
+
+	// MuzzleSocketNames resolved against MuzzleMesh
+	TArray<FMuzzleAttachment> MuzzleAttachments;
+
+	// Skeletal mesh MuzzleAttachments were resolved against
+	TWeakObjectPtr<class USkeletalMesh> MuzzleMesh;
+
+	// GFrameCounter when the muzzle world transforms were last computed
+	uint64 MuzzleTransformFrame;
 	
 	UPROPERTY(EditAnywhere,BlueprintReadWrite, Category= "Combat", meta=(AllowPrivateAccess="true"))
 	class UAnimMontage* HipFireMontage;
@@ -155,9 +230,25 @@ private:
 	UPROPERTY(EditAnywhere,BlueprintReadWrite, Category= "Combat", meta=(AllowPrivateAccess="true"))
 	UParticleSystem* BeamParticles;
 
+	//Max distance a shot travels from the crosshairs
+	UPROPERTY(EditAnywhere,BlueprintReadWrite, Category= "Combat", meta=(AllowPrivateAccess="true", ClampMin="0.0"))
+	float WeaponMaxRange;
+
+	//Channel for hitscan traces. Use a weapon trace channel that only simple collision proxies block
+	UPROPERTY(EditAnywhere,BlueprintReadWrite, Category= "Combat", meta=(AllowPrivateAccess="true"))
+	TEnumAsByte<ECollisionChannel> WeaponTraceChannel;
+
+	//For rigs whose barrel sits on the crosshair line (first person, scoped). Skips the screen trace, only the barrel traces
+	UPROPERTY(EditAnywhere,BlueprintReadWrite, Category= "Combat", meta=(AllowPrivateAccess="true"))
+	bool bBarrelTraceOnly;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category= "Combat",meta=(AllowPrivateAccess="true"))
 	bool bAiming;
 
+	// Aim state, zoom transitions run only while ZoomingIn or ZoomingOut
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category= "Combat",meta=(AllowPrivateAccess="true"))
+	EAimState AimState;
+
 	//Default camera field of view value
 	float CameraDefaultFOV;
 
@@ -202,7 +293,19 @@ private:
 	
 	float ShootTimeDuration;
 	bool bFiringBullet;
+	// True when the crosshair spread did not change last frame
+	bool bCrosshairSpreadSettled;
+	// Set by look and movement input on the local player, the item trace runs on the next Tick
+	bool bCrosshairViewChanged;
 	FTimerHandle CrosshairShootTimer;
+
+	// Shots since spawn, read by the soak test
+	uint32 ShotsFired;
+
+#if STATS
+	// Fire emitters spawned by this character that have not finished yet
+	TArray<TWeakObjectPtr<class UParticleSystemComponent>> LiveFireEmitters;
+#endif
  
 	
 public:
@@ -210,6 +313,18 @@ public:
 	FORCEINLINE UCameraComponent* GetFollowCamera(){return FollowCamera;}
 	FORCEINLINE bool GetAiming() const{return bAiming;}
 
+	// Hold or release the trigger without player input, used by bots and the soak test
+	void HoldFireButton(bool bHeld);
+
+	FORCEINLINE uint32 GetShotsFired() const{return ShotsFired;}
+
+	// Called by UShooterCharacterMovementComponent when velocity goes from zero to non-zero or back
+	void OnMovementStartedOrStopped();
+
+	// Replace the muzzle sockets, they are resolved against the mesh on the next shot
+	UFUNCTION(BlueprintCallable)
+	void SetMuzzleSocketNames(const TArray<FName>& InMuzzleSocketNames);
+
 	UFUNCTION(BlueprintCallable)
     float GetCrosshairSpreadMultiplier() const;
 };
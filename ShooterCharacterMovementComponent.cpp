@@ -0,0 +1,17 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "ShooterCharacterMovementComponent.h"
+#include "ShooterCharacter.h"
+
+void UShooterCharacterMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity)
+{
+	Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
+
+	// Only starting and stopping need a wake, Tick stays on by itself while the pawn keeps moving
+	if (Velocity.IsNearlyZero() != OldVelocity.IsNearlyZero())
+	{
+		if (AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(CharacterOwner))
+		{
+			ShooterCharacter->OnMovementStartedOrStopped();
+		}
+	}
+}
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "ShooterCharacterMovementComponent.generated.h"
+
+/**
+ * Wakes the owning AShooterCharacter's Tick when it starts or stops moving.
+ * Native replacement for binding OnCharacterMovementUpdated, which broadcast a dynamic
+ * delegate to every pawn on every movement update.
+ */
+UCLASS()
+class SHOOTERZX_API UShooterCharacterMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+protected:
+	// Runs after local, AI, server and simulated proxy movement
+	virtual void OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity) override;
+};
@@ -0,0 +1,245 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "ShooterSoakTest.h"
+#include "ShooterCharacter.h"
+#include "Components/ActorComponent.h"
+#include "GameFramework/GameModeBase.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "UObject/UObjectIterator.h"
+
+static TAutoConsoleVariable<float> CVarSoakSampleInterval(
+	TEXT("Shooter.Soak.SampleInterval"),
+	60.f,
+	TEXT("Seconds between soak test samples"));
+
+static TAutoConsoleVariable<float> CVarSoakMaxObjectSlope(
+	TEXT("Shooter.Soak.MaxObjectSlope"),
+	50.f,
+	TEXT("Fail the soak test when live UObjects grow faster than this per minute"));
+
+static TAutoConsoleVariable<float> CVarSoakMaxComponentSlope(
+	TEXT("Shooter.Soak.MaxComponentSlope"),
+	5.f,
+	TEXT("Fail the soak test when any component class grows faster than this per minute"));
+
+static TAutoConsoleVariable<float> CVarSoakMaxFireMemorySlope(
+	TEXT("Shooter.Soak.MaxFireMemorySlope"),
+	64.f * 1024.f,
+	TEXT("Fail the soak test when the ShooterFire LLM tag grows faster than this many bytes per minute. Needs -llm"));
+
+AShooterSoakTest::AShooterSoakTest() :
+	NumBots(0),
+	DurationMinutes(0.f),
+	StartTime(0.f)
+{
+	PrimaryActorTick.bCanEverTick = false;
+}
+
+void AShooterSoakTest::StartSoak(int32 InNumBots, float InDurationMinutes)
+{
+	NumBots = InNumBots;
+	DurationMinutes = InDurationMinutes;
+	StartTime = GetWorld()->GetTimeSeconds();
+
+	SpawnBots();
+
+	UE_LOG(LogTemp, Display, TEXT("Soak test: %d bots in auto fire for %.1f minutes"), Bots.Num(), DurationMinutes);
+	GetWorldTimerManager().SetTimer(SampleTimer, this, &AShooterSoakTest::TakeSample, CVarSoakSampleInterval.GetValueOnGameThread(), true);
+	GetWorldTimerManager().SetTimer(FinishTimer, this, &AShooterSoakTest::FinishSoak, DurationMinutes * 60.f);
+}
+
+void AShooterSoakTest::SpawnBots()
+{
+	// Use the game's pawn so the bots have the real meshes and fire cosmetics
+	UClass* BotClass = AShooterCharacter::StaticClass();
+	AGameModeBase* GameMode = GetWorld()->GetAuthGameMode();
+	if (GameMode && GameMode->DefaultPawnClass && GameMode->DefaultPawnClass->IsChildOf(AShooterCharacter::StaticClass()))
+	{
+		BotClass = GameMode->DefaultPawnClass;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	// Lay the bots out on a grid around the soak actor
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumBots)));
+	for (int32 BotIndex = 0; BotIndex < NumBots; ++BotIndex)
+	{
+		const FVector Offset{ (BotIndex % GridSize) * 200.f, (BotIndex / GridSize) * 200.f, 0.f };
+		AShooterCharacter* Bot = GetWorld()->SpawnActor<AShooterCharacter>(BotClass, GetActorLocation() + Offset, GetActorRotation(), SpawnParams);
+		if (Bot)
+		{
+			Bot->SpawnDefaultController();
+			Bot->HoldFireButton(true);
+			Bots.Add(Bot);
+		}
+	}
+}
+
+void AShooterSoakTest::TakeSample()
+{
+	// Purge unreachable objects first so the counts only hold what survives,
+	// not however much garbage the last GC left behind
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	SampleMinutes.Add((GetWorld()->GetTimeSeconds() - StartTime) / 60.f);
+	ObjectCounts.Add(static_cast<float>(GUObjectArray.GetObjectArrayNumMinusAvailable()));
+
+	int64 FireMemory = 0;
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	FireMemory = FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, FName(TEXT("ShooterFire")));
+#endif
+	FireMemoryBytes.Add(static_cast<float>(FireMemory));
+
+	TMap<FName, int32>& Counts = ComponentCounts.AddDefaulted_GetRef();
+	for (TObjectIterator<UActorComponent> It; It; ++It)
+	{
+		if (!It->IsTemplate() && !It->IsPendingKill())
+		{
+			++Counts.FindOrAdd(It->GetClass()->GetFName());
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Soak test sample at %.1f min: %.0f objects, %d component classes, %lld bytes in ShooterFire"),
+		SampleMinutes.Last(), ObjectCounts.Last(), Counts.Num(), FireMemory);
+}
+
+float AShooterSoakTest::FitSlope(const TArray<float>& Values) const
+{
+	// The first sample covers spawning and pool warm up, leave it out
+	const int32 First = 1;
+	const int32 Num = Values.Num() - First;
+	float MeanX = 0.f;
+	float MeanY = 0.f;
+	for (int32 Index = First; Index < Values.Num(); ++Index)
+	{
+		MeanX += SampleMinutes[Index];
+		MeanY += Values[Index];
+	}
+	MeanX /= Num;
+	MeanY /= Num;
+
+	float Covariance = 0.f;
+	float Variance = 0.f;
+	for (int32 Index = First; Index < Values.Num(); ++Index)
+	{
+		Covariance += (SampleMinutes[Index] - MeanX) * (Values[Index] - MeanY);
+		Variance += FMath::Square(SampleMinutes[Index] - MeanX);
+	}
+	return Variance > 0.f ? Covariance / Variance : 0.f;
+}
+
+void AShooterSoakTest::FinishSoak()
+{
+	GetWorldTimerManager().ClearTimer(SampleTimer);
+
+	bool bFailed = false;
+
+	// A run that never fired or never spawned a fire emitter proves nothing about the fire path
+	uint32 ShotsFired = 0;
+	for (const AShooterCharacter* Bot : Bots)
+	{
+		if (Bot)
+		{
+			ShotsFired += Bot->GetShotsFired();
+		}
+	}
+	int32 MaxEmitters = 0;
+	const FName EmitterClassName = UParticleSystemComponent::StaticClass()->GetFName();
+	for (const TMap<FName, int32>& Counts : ComponentCounts)
+	{
+		const int32* Count = Counts.Find(EmitterClassName);
+		MaxEmitters = FMath::Max(MaxEmitters, Count ? *Count : 0);
+	}
+	UE_LOG(LogTemp, Display, TEXT("Soak test: %u shots fired, at most %d particle system components alive"), ShotsFired, MaxEmitters);
+	if (ShotsFired == 0 || MaxEmitters == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Soak test: fire cosmetics were never exercised, run a game or listen server with the real pawn class, not a dedicated server"));
+		bFailed = true;
+	}
+
+	if (SampleMinutes.Num() < 3)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Soak test: only %d samples, run longer than three sample intervals"), SampleMinutes.Num());
+		bFailed = true;
+	}
+	else
+	{
+		const float ObjectSlope = FitSlope(ObjectCounts);
+		UE_LOG(LogTemp, Display, TEXT("Soak test: UObjects grow %.2f per minute"), ObjectSlope);
+		if (ObjectSlope > CVarSoakMaxObjectSlope.GetValueOnGameThread())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Soak test: UObject growth %.2f per minute is over the limit"), ObjectSlope);
+			bFailed = true;
+		}
+
+		const float FireMemorySlope = FitSlope(FireMemoryBytes);
+		UE_LOG(LogTemp, Display, TEXT("Soak test: ShooterFire memory grows %.0f bytes per minute"), FireMemorySlope);
+		if (FireMemorySlope > CVarSoakMaxFireMemorySlope.GetValueOnGameThread())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Soak test: ShooterFire memory growth %.0f bytes per minute is over the limit"), FireMemorySlope);
+			bFailed = true;
+		}
+
+		// A class missing from a sample had no live components then
+		TSet<FName> ComponentClasses;
+		for (const TMap<FName, int32>& Counts : ComponentCounts)
+		{
+			for (const TPair<FName, int32>& Count : Counts)
+			{
+				ComponentClasses.Add(Count.Key);
+			}
+		}
+		for (const FName& ComponentClass : ComponentClasses)
+		{
+			TArray<float> ClassCounts;
+			for (const TMap<FName, int32>& Counts : ComponentCounts)
+			{
+				const int32* Count = Counts.Find(ComponentClass);
+				ClassCounts.Add(Count ? static_cast<float>(*Count) : 0.f);
+			}
+			const float ComponentSlope = FitSlope(ClassCounts);
+			if (ComponentSlope > CVarSoakMaxComponentSlope.GetValueOnGameThread())
+			{
+				UE_LOG(LogTemp, Error, TEXT("Soak test: %s components grow %.2f per minute, over the limit"), *ComponentClass.ToString(), ComponentSlope);
+				bFailed = true;
+			}
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Soak test %s"), bFailed ? TEXT("FAILED") : TEXT("passed"));
+	FPlatformMisc::RequestExitWithStatus(false, bFailed ? 1 : 0);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs ShooterSoakCommand(
+	TEXT("Shooter.Soak"),
+	TEXT("Shooter.Soak <Bots> <Minutes>: bots fire continuously, then exit non-zero if growth is over the Shooter.Soak.* slopes"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+		const int32 NumBots = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 64;
+		const float DurationMinutes = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 60.f;
+		// A zero timer rate clears the finish timer and the run would never exit
+		if (NumBots <= 0 || DurationMinutes <= 0.f || CVarSoakSampleInterval.GetValueOnGameThread() <= 0.f)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Usage: Shooter.Soak <Bots> <Minutes>, both above zero, and Shooter.Soak.SampleInterval above zero"));
+			return;
+		}
+
+		// Spawn around the local player, or the world origin when running without one
+		FVector Location = FVector::ZeroVector;
+		if (APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(World, 0))
+		{
+			Location = PlayerPawn->GetActorLocation() + PlayerPawn->GetActorForwardVector() * 500.f;
+		}
+		AShooterSoakTest* Soak = World->SpawnActor<AShooterSoakTest>(Location, FRotator::ZeroRotator);
+		if (Soak)
+		{
+			Soak->StartSoak(NumBots, DurationMinutes);
+		}
+	}));
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ShooterSoakTest.generated.h"
+
+/**
+ * Headless soak test for the fire path, started with "Shooter.Soak <Bots> <Minutes>"
+ * (e.g. -nullrhi -ExecCmds="Shooter.Soak 64 180"). Spawns bots holding the fire button,
+ * samples UObject, component and ShooterFire LLM counts, then exits with a non-zero
+ * status when any of them grows faster than the Shooter.Soak.* slopes.
+ */
+UCLASS()
+class SHOOTERZX_API AShooterSoakTest : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AShooterSoakTest();
+
+	// Spawn the bots and start sampling. InDurationMinutes must be above zero
+	void StartSoak(int32 InNumBots, float InDurationMinutes);
+
+private:
+	void SpawnBots();
+
+	UFUNCTION()
+	void TakeSample();
+
+	UFUNCTION()
+	void FinishSoak();
+
+	// Least squares slope of Values over SampleMinutes, skipping the warm up sample
+	float FitSlope(const TArray<float>& Values) const;
+
+	int32 NumBots;
+	float DurationMinutes;
+	float StartTime;
+
+	UPROPERTY()
+	TArray<class AShooterCharacter*> Bots;
+
+	// One entry per sample
+	TArray<float> SampleMinutes;
+	TArray<float> ObjectCounts;
+	TArray<float> FireMemoryBytes;
+	TArray<TMap<FName, int32>> ComponentCounts;
+
+	FTimerHandle SampleTimer;
+	FTimerHandle FinishTimer;
+};
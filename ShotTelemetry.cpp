@@ -0,0 +1,209 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "ShotTelemetry.h"
+#include "Containers/CircularQueue.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+static constexpr uint32 ShotTelemetryMagic = 0x544F4853; // "SHOT"
+static constexpr uint32 ShotTelemetryVersion = 1;
+
+static void OnShotTelemetryChanged(IConsoleVariable* Var);
+
+static int32 GShotTelemetry = 0;
+static FAutoConsoleVariableRef CVarShotTelemetry(
+	TEXT("Shooter.ShotTelemetry"),
+	GShotTelemetry,
+	TEXT("Write every fired shot to Saved/Telemetry. 0: off, 1: on"),
+	FConsoleVariableDelegate::CreateStatic(&OnShotTelemetryChanged));
+
+/** Drains the shot queue to a file on its own thread */
+class FShotTelemetryWriter : public FRunnable
+{
+public:
+	FShotTelemetryWriter(FArchive* InFile) :
+		// Capacity must be a power of two, ~2.6MB holds seconds of full auto at 64 players
+		Queue(1 << 16),
+		File(InFile),
+		bStopping(false),
+		DroppedShots(0)
+	{
+		FShotTelemetryHeader Header{ ShotTelemetryMagic, ShotTelemetryVersion, sizeof(FShotRecord), 0 };
+		File->Serialize(&Header, sizeof(Header));
+		Thread = FRunnableThread::Create(this, TEXT("ShotTelemetryWriter"), 0, TPri_BelowNormal);
+	}
+
+	virtual ~FShotTelemetryWriter() override
+	{
+		bStopping = true;
+		if (Thread)
+		{
+			Thread->WaitForCompletion();
+			delete Thread;
+		}
+		File->Close();
+		delete File;
+		if (DroppedShots > 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Shot telemetry dropped %d shots, writer could not keep up"), DroppedShots);
+		}
+	}
+
+	void Push(const FShotRecord& Shot)
+	{
+		if (!Queue.Enqueue(Shot))
+		{
+			// Queue full, never block the game thread on the writer
+			++DroppedShots;
+		}
+	}
+
+	virtual uint32 Run() override
+	{
+		while (!bStopping)
+		{
+			Drain();
+			FPlatformProcess::Sleep(0.01f);
+		}
+		// Pick up anything queued before Stop
+		Drain();
+		File->Flush();
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStopping = true;
+	}
+
+private:
+	void Drain()
+	{
+		FShotRecord Shot;
+		while (Queue.Dequeue(Shot))
+		{
+			Batch.Add(Shot);
+		}
+		if (Batch.Num() > 0)
+		{
+			File->Serialize(Batch.GetData(), Batch.Num() * sizeof(FShotRecord));
+			Batch.Reset();
+		}
+	}
+
+	TCircularQueue<FShotRecord> Queue;
+	FArchive* File;
+	FRunnableThread* Thread;
+	// Only touched by the writer thread
+	TArray<FShotRecord> Batch;
+	TAtomic<bool> bStopping;
+	// Only touched by the game thread
+	int32 DroppedShots;
+};
+
+static FShotTelemetryWriter* ShotWriter = nullptr;
+bool FShotTelemetry::bEnabled = false;
+
+static void OnShotTelemetryChanged(IConsoleVariable* Var)
+{
+	// Do the file and thread setup here so the first shot does not pay for it
+	if (Var->GetInt() != 0)
+	{
+		FShotTelemetry::Startup();
+	}
+	else
+	{
+		FShotTelemetry::Shutdown();
+	}
+}
+
+void FShotTelemetry::Record(const FShotRecord& Shot)
+{
+	checkSlow(IsInGameThread());
+	if (bEnabled)
+	{
+		ShotWriter->Push(Shot);
+	}
+}
+
+void FShotTelemetry::Startup()
+{
+	if (ShotWriter)
+	{
+		return;
+	}
+	const FString Filename = FPaths::ProjectSavedDir() / TEXT("Telemetry") /
+		FString::Printf(TEXT("Shots-%s.bin"), *FDateTime::Now().ToString());
+	FArchive* File = IFileManager::Get().CreateFileWriter(*Filename);
+	if (!File)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Shot telemetry could not open %s"), *Filename);
+		return;
+	}
+	ShotWriter = new FShotTelemetryWriter(File);
+	bEnabled = true;
+
+	static bool bBoundPreExit = false;
+	if (!bBoundPreExit)
+	{
+		FCoreDelegates::OnPreExit.AddStatic(&FShotTelemetry::Shutdown);
+		bBoundPreExit = true;
+	}
+}
+
+void FShotTelemetry::Shutdown()
+{
+	bEnabled = false;
+	delete ShotWriter;
+	ShotWriter = nullptr;
+}
+
+bool FShotTelemetry::ReadFile(const FString& Filename, TArray<FShotRecord>& OutShots)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Filename) || Bytes.Num() < static_cast<int32>(sizeof(FShotTelemetryHeader)))
+	{
+		return false;
+	}
+	const FShotTelemetryHeader* Header = reinterpret_cast<const FShotTelemetryHeader*>(Bytes.GetData());
+	if (Header->Magic != ShotTelemetryMagic || Header->Version != ShotTelemetryVersion || Header->RecordSize != sizeof(FShotRecord))
+	{
+		return false;
+	}
+	const int32 NumShots = (Bytes.Num() - static_cast<int32>(sizeof(FShotTelemetryHeader))) / static_cast<int32>(sizeof(FShotRecord));
+	OutShots.SetNumUninitialized(NumShots);
+	FMemory::Memcpy(OutShots.GetData(), Bytes.GetData() + sizeof(FShotTelemetryHeader), NumShots * sizeof(FShotRecord));
+	return true;
+}
+
+// Reader tool: Shooter.DumpShotTelemetry <file> prints every shot in a telemetry file
+static FAutoConsoleCommand DumpShotTelemetryCommand(
+	TEXT("Shooter.DumpShotTelemetry"),
+	TEXT("Print the shots stored in a shot telemetry file"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		TArray<FShotRecord> Shots;
+		if (Args.Num() < 1 || !FShotTelemetry::ReadFile(Args[0], Shots))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Usage: Shooter.DumpShotTelemetry <file>, file must be a shot telemetry file"));
+			return;
+		}
+		for (const FShotRecord& Shot : Shots)
+		{
+			UE_LOG(LogTemp, Log, TEXT("%.3f shooter=%u muzzle=(%s) end=(%s) spread=%.2f screenhit=%d weaponhit=%d aiming=%d screenskipped=%d nodeprojection=%d"),
+				Shot.TimeSeconds,
+				Shot.ShooterId,
+				*Shot.MuzzleLocation.ToString(),
+				*Shot.BeamEnd.ToString(),
+				Shot.SpreadMultiplier,
+				(Shot.Flags & EShotFlags::ScreenTraceHit) != 0,
+				(Shot.Flags & EShotFlags::WeaponTraceHit) != 0,
+				(Shot.Flags & EShotFlags::Aiming) != 0,
+				(Shot.Flags & EShotFlags::ScreenTraceSkipped) != 0,
+				(Shot.Flags & EShotFlags::NoDeprojection) != 0);
+		}
+	}));
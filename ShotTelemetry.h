@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Bits stored in FShotRecord::Flags
+namespace EShotFlags
+{
+	enum Type : uint8
+	{
+		ScreenTraceHit = 1 << 0,
+		WeaponTraceHit = 1 << 1,
+		Aiming = 1 << 2,
+		// Weapon uses bBarrelTraceOnly, only the weapon trace ran
+		ScreenTraceSkipped = 1 << 3,
+		// The local player's crosshairs could not be deprojected, no traces ran and BeamEnd is zero
+		NoDeprojection = 1 << 4,
+		// ShooterId is the PlayerState player id, otherwise a hash of actor name and spawn time
+		ShooterIdIsPlayerId = 1 << 5,
+	};
+}
+
+/** One fired shot. Written to disk as-is, so the layout is the file format. */
+struct FShotRecord
+{
+	// World time of the shot in seconds
+	float TimeSeconds;
+	// Stable id of the shooter for the session, see EShotFlags::ShooterIdIsPlayerId
+	uint32 ShooterId;
+	FVector MuzzleLocation;
+	FVector BeamEnd;
+	// Crosshair spread multiplier at fire time
+	float SpreadMultiplier;
+	// EShotFlags bits
+	uint8 Flags;
+	uint8 Pad[3];
+};
+static_assert(sizeof(FShotRecord) == 40, "FShotRecord is the on-disk format, bump ShotTelemetryVersion when changing it");
+
+/** File header, followed by a packed array of FShotRecord until end of file. */
+struct FShotTelemetryHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint32 RecordSize;
+	uint32 Reserved;
+};
+
+/**
+ * Shot log for balancing and anti-cheat, enabled with Shooter.ShotTelemetry 1.
+ * Setting the cvar opens the file and starts the writer thread. Record only copies the
+ * shot into a lock-free single producer queue, the thread drains it to
+ * Saved/Telemetry/Shots-<timestamp>.bin.
+ */
+class SHOOTERZX_API FShotTelemetry
+{
+public:
+	// True while the writer thread is running. Check before building a record so a disabled log costs one branch.
+	static FORCEINLINE bool IsEnabled() { return bEnabled; }
+
+	// Queue a shot for writing. Game thread only, the queue has a single producer.
+	static void Record(const FShotRecord& Shot);
+
+	// Open a new file and start the writer thread
+	static void Startup();
+
+	// Flush queued shots and stop the writer thread
+	static void Shutdown();
+
+	// Reader for files written by the writer thread. Returns false on a bad header.
+	static bool ReadFile(const FString& Filename, TArray<FShotRecord>& OutShots);
+
+private:
+	// Set by Startup and Shutdown, both on the game thread
+	static bool bEnabled;
+};